@@ -0,0 +1,261 @@
+#include "Benchmark.h"
+#include "ParallelSort.h"
+#include "Workload.h"
+#include "SortingVisualizer.h"
+#include "FrameExporter.h"
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <QVector>
+#include <algorithm>
+#include <climits>
+#include <limits>
+#include <type_traits>
+
+namespace {
+
+// Reads "--name <value>" from the command line into *value, which is left
+// alone when the option is absent. Values that are malformed, below minimum
+// or too large for T are reported and fail.
+template <typename T>
+bool intOption(const QStringList &arguments, const QString &name, T minimum, T *value, QTextStream &out) {
+    int index = arguments.indexOf(name);
+    if (index < 0) {
+        return true;
+    }
+    bool ok = index + 1 < arguments.size();
+    if (ok) {
+        if constexpr (std::is_unsigned<T>::value) {
+            quint64 parsed = arguments[index + 1].toULongLong(&ok);
+            ok = ok && parsed >= minimum && parsed <= std::numeric_limits<T>::max();
+            if (ok) {
+                *value = static_cast<T>(parsed);
+            }
+        } else {
+            qint64 parsed = arguments[index + 1].toLongLong(&ok);
+            ok = ok && parsed >= minimum && parsed <= std::numeric_limits<T>::max();
+            if (ok) {
+                *value = static_cast<T>(parsed);
+            }
+        }
+    }
+    if (!ok) {
+        out << "Invalid value for " << name << ", expected an integer from " << minimum
+            << " to " << std::numeric_limits<T>::max() << "\n";
+    }
+    return ok;
+}
+
+// Catalog entry with the command line overrides applied. inMemory specs feed
+// the QVector<int> working array and must fit an int.
+bool datasetSpec(const QStringList &arguments, const QString &name, Workload::Spec *spec, QTextStream &out,
+                 bool inMemory) {
+    const Workload::Spec *entry = Workload::find(name);
+    if (!entry) {
+        out << "Unknown dataset " << name << ", run with --list-datasets\n";
+        return false;
+    }
+    *spec = *entry;
+
+    int index = arguments.indexOf("--distribution");
+    if (index >= 0 && index + 1 < arguments.size()
+        && !Workload::distributionFromName(arguments[index + 1], &spec->distribution)) {
+        out << "Unknown distribution " << arguments[index + 1] << ", expected one of "
+            << Workload::distributionNames().join(", ") << "\n";
+        return false;
+    }
+    if (!intOption<qint64>(arguments, "--size", 1, &spec->size, out)
+        || !intOption<quint64>(arguments, "--seed", 0, &spec->seed, out)
+        || !intOption<int>(arguments, "--bits", 32, &spec->bits, out)
+        || !intOption<quint64>(arguments, "--range", 0, &spec->range, out)) {
+        return false;
+    }
+    if (spec->bits != 32 && spec->bits != 64) {
+        out << "Invalid value for --bits, expected 32 or 64\n";
+        return false;
+    }
+    if (inMemory && spec->size > INT_MAX) {
+        out << "--size " << spec->size << " does not fit the in-memory working array (at most " << INT_MAX
+            << "), use --generate for larger datasets\n";
+        return false;
+    }
+    if (arguments.contains("--signed")) {
+        spec->isSigned = true;
+    } else if (arguments.contains("--unsigned")) {
+        spec->isSigned = false;
+    }
+    return true;
+}
+
+} // namespace
+
+int runBenchmark(const QStringList &arguments) {
+    QTextStream out(stdout);
+    int index = arguments.indexOf("--dataset");
+    QString name = index >= 0 && index + 1 < arguments.size() ? arguments[index + 1] : QString("uniform-4m");
+    Workload::Spec spec;
+    int maxThreads = ParallelSort::defaultThreadCount();
+    if (!datasetSpec(arguments, name, &spec, out, true) || !intOption(arguments, "--threads", 1, &maxThreads, out)) {
+        return 2;
+    }
+    const int size = static_cast<int>(spec.size);
+    QVector<int> input;
+    Workload::generate(spec, input);
+    out << "dataset " << spec.name << "  seed " << spec.seed << "\n";
+
+    // Single threaded baseline
+    QVector<int> reference = input;
+    QElapsedTimer timer;
+    timer.start();
+    std::sort(reference.begin(), reference.end());
+    out << "std::sort          n=" << size << "  " << timer.elapsed() << " ms\n";
+
+    // 1, 2, 4, ... up to and including maxThreads
+    QVector<int> threadCounts;
+    for (int threads = 1; threads < maxThreads; threads *= 2) {
+        threadCounts.append(threads);
+    }
+    threadCounts.append(maxThreads);
+
+    bool allSorted = true;
+    QStringList imbalanced;
+    const QStringList engines = {"Sample Sort", "Bucket Sort"};
+    for (const QString &engine : engines) {
+        qint64 singleThreadNs = 0;
+        for (int threads : threadCounts) {
+            QVector<int> data = input;
+            timer.start();
+            ParallelSort::Stats stats = engine == "Sample Sort" ? ParallelSort::sampleSort(data, threads)
+                                                                : ParallelSort::bucketSort(data, threads);
+            qint64 elapsedNs = timer.nsecsElapsed();
+            if (threads == 1) {
+                singleThreadNs = elapsedNs;
+            }
+
+            bool sorted = data == reference;
+            allSorted = allSorted && sorted;
+            out << qSetFieldWidth(18) << Qt::left << engine << qSetFieldWidth(0)
+                << " threads=" << stats.threads
+                << "  " << elapsedNs / 1000000 << " ms"
+                << " (classify " << stats.classifyNs / 1000000 << " ms, sort " << stats.sortNs / 1000000 << " ms)"
+                << "  speedup " << QString::number(static_cast<double>(singleThreadNs) / elapsedNs, 'f', 2)
+                << "  buckets " << stats.buckets
+                << "  equality " << stats.equalityBuckets
+                << "  imbalance " << QString::number(stats.imbalance, 'f', 2)
+                << (sorted ? "" : "  NOT SORTED") << "\n";
+            if (threads == maxThreads && stats.imbalance > 2.0) {
+                // Equal keys cannot be split across buckets; bucket sort only gets
+                // equality buckets when the value range is narrower than its bucket count
+                imbalanced.append(engine);
+            }
+        }
+    }
+
+    if (!imbalanced.isEmpty()) {
+        out << "note: " << imbalanced.join(" and ") << " left a bucket over twice the ideal size;"
+               " equal keys always share one bucket, so a few heavy values spread over a wide range"
+               " limit the speedup\n";
+    }
+
+    out.flush();
+    return allSorted ? 0 : 1;
+}
+
+int runGenerator(const QStringList &arguments) {
+    QTextStream out(stdout);
+    int index = arguments.indexOf("--generate");
+    if (index < 0 || index + 2 >= arguments.size()) {
+        out << "Usage: --generate <dataset> <file> [--size N] [--seed S] [--bits 32|64] [--signed|--unsigned]"
+               " [--range R] [--distribution D] [--threads T]\n";
+        return 2;
+    }
+
+    Workload::Spec spec;
+    int threads = 0;
+    if (!datasetSpec(arguments, arguments[index + 1], &spec, out, false)
+        || !intOption(arguments, "--threads", 0, &threads, out)) {
+        return 2;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    QString error;
+    if (!Workload::writeBinary(spec, arguments[index + 2], threads, &error)) {
+        out << error << "\n";
+        return 1;
+    }
+    out << "Wrote " << spec.size << " " << (spec.isSigned ? "signed" : "unsigned") << " " << spec.bits
+        << "-bit values of " << spec.name << " (seed " << spec.seed << ") to " << arguments[index + 2]
+        << " in " << timer.elapsed() << " ms\n";
+    return 0;
+}
+
+int listDatasets() {
+    QTextStream out(stdout);
+    for (const Workload::Spec &spec : Workload::catalog()) {
+        out << qSetFieldWidth(18) << Qt::left << spec.name << qSetFieldWidth(0)
+            << " n=" << spec.size << "  " << (spec.isSigned ? "i" : "u") << spec.bits
+            << "  seed " << spec.seed << "\n";
+    }
+    return 0;
+}
+
+int runExport(const QStringList &arguments) {
+    QTextStream out(stdout);
+    int index = arguments.indexOf("--export");
+    if (index < 0 || index + 2 >= arguments.size()) {
+        out << "Usage: --export <algorithm> <file.gif|prefix.png> [--dataset NAME | --input LIST]"
+               " [--width W] [--height H] [--fps F] [--seconds S] [--threads T]\n";
+        return 2;
+    }
+
+    // Input as the GUI would receive it: a comma separated list
+    QString input;
+    int inputIndex = arguments.indexOf("--input");
+    if (inputIndex >= 0 && inputIndex + 1 < arguments.size()) {
+        input = arguments[inputIndex + 1];
+    } else {
+        int datasetIndex = arguments.indexOf("--dataset");
+        QString name = datasetIndex >= 0 && datasetIndex + 1 < arguments.size() ? arguments[datasetIndex + 1] : QString("uniform-60");
+        Workload::Spec spec;
+        if (!datasetSpec(arguments, name, &spec, out, true)) {
+            return 2;
+        }
+        QVector<int> values;
+        Workload::generate(spec, values);
+        QStringList text;
+        for (int value : values) {
+            text.append(QString::number(value));
+        }
+        input = text.join(",");
+    }
+
+    FrameExporter::Options options;
+    options.path = arguments[index + 2];
+    options.format = FrameExporter::formatForPath(options.path);
+    int seconds = 0;
+    if (!intOption(arguments, "--width", 1, &options.width, out)
+        || !intOption(arguments, "--height", 1, &options.height, out)
+        || !intOption(arguments, "--fps", 1, &options.fps, out)
+        || !intOption(arguments, "--seconds", 0, &seconds, out)
+        || !intOption(arguments, "--threads", 0, &options.threads, out)) {
+        return 2;
+    }
+    options.seconds = seconds;
+
+    SortingVisualizer visualizer;
+    if (!visualizer.recordTrace(arguments[index + 1], input)) {
+        out << "No trace recorded for " << arguments[index + 1] << "\n";
+        return 1;
+    }
+
+    FrameExporter::Result result;
+    QString error;
+    if (!visualizer.exportFrames(options, &result, &error)) {
+        out << error << "\n";
+        return 1;
+    }
+    out << "Exported " << result.frames << " frames at " << result.fps << " fps from " << result.steps
+        << " steps to " << options.path
+        << " in " << result.elapsedMs << " ms\n";
+    return 0;
+}
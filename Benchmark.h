@@ -0,0 +1,24 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <QStringList>
+
+// Headless entry points, they return the process exit code.
+
+// `project_SD --bench [--dataset NAME] [options]`: prints timings, speedup over
+// one thread and bucket load imbalance for the parallel engines.
+int runBenchmark(const QStringList &arguments);
+
+// `project_SD --generate NAME FILE [options]`: writes a catalog dataset to a raw
+// binary file.
+int runGenerator(const QStringList &arguments);
+
+// `project_SD --list-datasets`: prints the dataset catalog.
+int listDatasets();
+
+// `project_SD --export ALGORITHM FILE [--dataset NAME | --input LIST] [options]`:
+// records one run and renders it to a GIF or PNG sequence without showing a
+// window. Needs a QApplication.
+int runExport(const QStringList &arguments);
+
+#endif // BENCHMARK_H
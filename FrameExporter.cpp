@@ -0,0 +1,272 @@
+#include "FrameExporter.h"
+#include "GifWriter.h"
+#include "ParallelSort.h"
+#include <QColor>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFont>
+#include <QImage>
+#include <QPainter>
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+namespace FrameExporter {
+
+namespace {
+
+// Every color a frame can contain, index 0 is the background
+const QVector<QRgb> &palette() {
+    static const QVector<QRgb> colors = {
+        QColor(Qt::white).rgb(), QColor(Qt::black).rgb(), QColor(Qt::red).rgb(), QColor(Qt::green).rgb(),
+        QColor(Qt::blue).rgb(), QColor(Qt::yellow).rgb(), qRgb(128, 128, 128), qRgb(192, 192, 192),
+    };
+    return colors;
+}
+
+int nearestColor(QRgb pixel) {
+    const QVector<QRgb> &colors = palette();
+    int best = 0;
+    int bestDistance = INT_MAX;
+    for (int i = 0; i < colors.size(); ++i) {
+        int dr = qRed(pixel) - qRed(colors[i]);
+        int dg = qGreen(pixel) - qGreen(colors[i]);
+        int db = qBlue(pixel) - qBlue(colors[i]);
+        int distance = dr * dr + dg * dg + db * db;
+        if (distance < bestDistance) {
+            best = i;
+            bestDistance = distance;
+        }
+    }
+    return best;
+}
+
+// Map an RGB32 frame onto the palette. Bars are long runs of one color, so
+// the previous pixel is checked first and the search only runs on edges and
+// antialiased text.
+void toIndices(const QImage &image, std::vector<uchar> &indices) {
+    const int width = image.width();
+    indices.resize(static_cast<size_t>(width) * image.height());
+    QRgb previous = palette()[0];
+    uchar previousIndex = 0;
+    for (int y = 0; y < image.height(); ++y) {
+        const QRgb *line = reinterpret_cast<const QRgb *>(image.constScanLine(y));
+        uchar *out = &indices[static_cast<size_t>(y) * width];
+        for (int x = 0; x < width; ++x) {
+            QRgb pixel = line[x] | 0xff000000;
+            if (pixel != previous) {
+                previous = pixel;
+                previousIndex = static_cast<uchar>(nearestColor(pixel));
+            }
+            out[x] = previousIndex;
+        }
+    }
+}
+
+// Same color scheme as SortingVisualizer::drawArray: red and green are the
+// highlighted pair, blue unsorted, everything yellow once sorting is done
+void renderFrame(QImage &image, const QVector<int> &values, int highlightIndex1, int highlightIndex2, bool finished) {
+    image.fill(Qt::white);
+    const int n = values.size();
+    if (n == 0) {
+        return;
+    }
+
+    const int width = image.width();
+    const int height = image.height();
+    auto range = std::minmax_element(values.begin(), values.end());
+    const qint64 base = qMin(0, *range.first);
+    const qint64 span = qMax<qint64>(1, *range.second - base);
+    const double barWidth = static_cast<double>(width) / n;
+    const bool outline = barWidth >= 4;
+    const bool labels = barWidth >= 18;
+    const int labelHeight = labels ? 20 : 0;
+    const int usable = height - labelHeight - 1;
+
+    QPainter painter(&image);
+    painter.setPen(outline ? QPen(Qt::black) : QPen(Qt::NoPen));
+    if (labels) {
+        QFont font = painter.font();
+        font.setPixelSize(qBound(8, static_cast<int>(barWidth / 3), 14));
+        painter.setFont(font);
+    }
+
+    for (int i = 0; i < n; ++i) {
+        QColor barColor = finished ? Qt::yellow : (i == highlightIndex1) ? Qt::red : (i == highlightIndex2) ? Qt::green : Qt::blue;
+        int x0 = static_cast<int>(i * barWidth);
+        int x1 = static_cast<int>((i + 1) * barWidth);
+        int barHeight = static_cast<int>(usable * (values[i] - base) / span);
+
+        painter.setBrush(barColor);
+        if (outline) {
+            painter.drawRect(x0, height - barHeight - 1, x1 - x0 - 1, barHeight);
+        } else {
+            painter.fillRect(x0, height - barHeight, qMax(1, x1 - x0), barHeight, barColor);
+        }
+        if (labels) {
+            painter.drawText(QRect(x0, height - barHeight - labelHeight - 1, x1 - x0, labelHeight),
+                             Qt::AlignCenter, QString::number(values[i]));
+        }
+    }
+}
+
+} // namespace
+
+Format formatForPath(const QString &path) {
+    return path.endsWith(".gif", Qt::CaseInsensitive) ? Format::Gif : Format::PngSequence;
+}
+
+bool exportTrace(const QVector<QVector<int>> &steps, const QVector<QPair<int, int>> &highlights,
+                 const Options &options, Result *result, QString *error) {
+    QElapsedTimer timer;
+    timer.start();
+
+    if (steps.isEmpty()) {
+        if (error) {
+            *error = "Nothing to export, run an algorithm first";
+        }
+        return false;
+    }
+
+    // Sample the steps down to fit the target duration
+    const int stepCount = steps.size();
+    const bool gif = options.format == Format::Gif;
+    const int fps = gif ? qBound(1, options.fps, kMaxGifFps) : qMax(1, options.fps);
+    const int frames = options.seconds > 0 ? qBound(1, static_cast<int>(options.seconds * fps), stepCount) : stepCount;
+    auto stepForFrame = [&](int frame) {
+        return frames == 1 ? stepCount - 1 : static_cast<int>(static_cast<qint64>(frame) * (stepCount - 1) / (frames - 1));
+    };
+
+    int threads = options.threads > 0 ? options.threads : ParallelSort::defaultThreadCount();
+    threads = qBound(1, threads, frames);
+    const int width = qMax(16, options.width);
+    const int height = qMax(16, options.height);
+    // Delays are rounded on the cumulative timeline so the total duration
+    // does not drift, e.g. 30 fps alternates 3 and 4 centiseconds
+    auto delayForFrame = [fps](int frame) {
+        return qRound((frame + 1) * 100.0 / fps) - qRound(frame * 100.0 / fps);
+    };
+    QString prefix = options.path;
+    if (prefix.endsWith(".png", Qt::CaseInsensitive)) {
+        prefix.chop(4);
+    }
+
+    // Encoded GIF frames wait here until the writer has appended them
+    std::vector<QByteArray> encoded(gif ? frames : 0);
+    std::vector<char> ready(gif ? frames : 0, 0);
+    std::mutex mutex;
+    std::condition_variable frameReady;
+    std::atomic<bool> failed(false);
+    QString failure;
+
+    auto fail = [&](const QString &message) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!failed) {
+            failure = message;
+            failed = true;
+        }
+        frameReady.notify_all();
+    };
+
+    // Thread 0 writes the GIF in frame order, the others each render one keyframe range
+    ParallelSort::runParallel(threads + 1, [&](int t) {
+        if (t == 0) {
+            if (!gif) {
+                return;
+            }
+            QFile file(options.path);
+            if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+                fail("Cannot write " + options.path + ": " + file.errorString());
+                return;
+            }
+            const QByteArray header = GifWriter::header(width, height, palette());
+            if (file.write(header) != header.size()) {
+                fail("Cannot write " + options.path + ": " + file.errorString());
+                return;
+            }
+            for (int frame = 0; frame < frames; ++frame) {
+                QByteArray data;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    frameReady.wait(lock, [&] { return ready[frame] || failed; });
+                    if (failed) {
+                        return;
+                    }
+                    data.swap(encoded[frame]);
+                }
+                if (file.write(data) != data.size()) {
+                    fail("Cannot write " + options.path + ": " + file.errorString());
+                    return;
+                }
+            }
+            const QByteArray trailer = GifWriter::trailer();
+            if (file.write(trailer) != trailer.size() || !file.flush()) {
+                fail("Cannot write " + options.path + ": " + file.errorString());
+                return;
+            }
+            file.close();
+            if (file.error() != QFileDevice::NoError) {
+                fail("Cannot write " + options.path + ": " + file.errorString());
+            }
+            return;
+        }
+
+        const int worker = t - 1;
+        const int begin = static_cast<int>(static_cast<qint64>(frames) * worker / threads);
+        const int end = static_cast<int>(static_cast<qint64>(frames) * (worker + 1) / threads);
+        QImage image(width, height, QImage::Format_RGB32);
+        std::vector<uchar> indices;
+
+        for (int frame = begin; frame < end && !failed; ++frame) {
+            int step = stepForFrame(frame);
+            bool finished = step == stepCount - 1;
+            int highlightIndex1 = step < highlights.size() ? highlights[step].first : -1;
+            int highlightIndex2 = step < highlights.size() ? highlights[step].second : -1;
+            renderFrame(image, steps[step], highlightIndex1, highlightIndex2, finished);
+
+            if (gif) {
+                toIndices(image, indices);
+                QByteArray data = GifWriter::frame(indices.data(), width, height, width, delayForFrame(frame),
+                                                   palette().size());
+#ifndef QT_NO_DEBUG
+                // Debug builds decode the first frame of every range again to check the encoder
+                QByteArray decoded;
+                if (frame == begin
+                    && (!GifWriter::decodeFrame(data, width, height, &decoded)
+                        || decoded != QByteArray(reinterpret_cast<const char *>(indices.data()),
+                                                 static_cast<int>(indices.size())))) {
+                    fail("GIF encoder round trip failed on frame " + QString::number(frame));
+                }
+#endif
+                std::lock_guard<std::mutex> lock(mutex);
+                encoded[frame].swap(data);
+                ready[frame] = 1;
+                frameReady.notify_all();
+            } else {
+                QString fileName = QString("%1_%2.png").arg(prefix).arg(frame, 6, 10, QChar('0'));
+                if (!image.save(fileName, "PNG")) {
+                    fail("Cannot write " + fileName);
+                }
+            }
+        }
+    });
+
+    if (failed) {
+        if (error) {
+            *error = failure;
+        }
+        return false;
+    }
+    if (result) {
+        result->frames = frames;
+        result->steps = stepCount;
+        result->fps = fps;
+        result->elapsedMs = timer.elapsed();
+    }
+    return true;
+}
+
+} // namespace FrameExporter
@@ -0,0 +1,46 @@
+#ifndef FRAMEEXPORTER_H
+#define FRAMEEXPORTER_H
+
+#include <QPair>
+#include <QString>
+#include <QVector>
+
+// Offline export of a recorded trace (steps + highlights) to a PNG image
+// sequence or an animated GIF. Frames are rasterized straight into QImages,
+// without a QGraphicsScene, on several threads that each take a contiguous
+// range of frames; the calling thread writes the encoded frames in order as
+// they become ready.
+namespace FrameExporter {
+
+enum class Format { PngSequence, Gif };
+
+// GIF delays are whole centiseconds and most viewers slow down anything
+// below 2, so 50 fps is the fastest GIF that plays at its intended speed
+const int kMaxGifFps = 50;
+
+struct Options {
+    QString path;          // GIF file, or the PNG files as path_000000.png (a trailing .png is dropped)
+    Format format = Format::Gif;
+    int width = 1280;
+    int height = 720;
+    int fps = 25;          // GIF is capped at kMaxGifFps
+    double seconds = 0;    // target duration, steps are sampled down to fit; 0 keeps every step
+    int threads = 0;       // 0 uses every core
+};
+
+struct Result {
+    int frames = 0;
+    int steps = 0;
+    int fps = 0;           // frame rate actually used
+    qint64 elapsedMs = 0;
+};
+
+// Picks the format from the path: ".gif" exports a GIF, anything else a PNG sequence.
+Format formatForPath(const QString &path);
+
+bool exportTrace(const QVector<QVector<int>> &steps, const QVector<QPair<int, int>> &highlights,
+                 const Options &options, Result *result = nullptr, QString *error = nullptr);
+
+} // namespace FrameExporter
+
+#endif // FRAMEEXPORTER_H
@@ -0,0 +1,250 @@
+#include "GifWriter.h"
+#include <algorithm>
+#include <vector>
+
+namespace GifWriter {
+
+namespace {
+
+// Bits per palette index, GIF needs at least 2
+int paletteBits(int paletteSize) {
+    int bits = 2;
+    while ((1 << bits) < paletteSize && bits < 8) {
+        bits++;
+    }
+    return bits;
+}
+
+void appendWord(QByteArray &out, int value) {
+    out.append(static_cast<char>(value & 0xff));
+    out.append(static_cast<char>((value >> 8) & 0xff));
+}
+
+// LSB-first bit packer that emits 255 byte data sub-blocks
+class CodeWriter {
+public:
+    explicit CodeWriter(QByteArray &out) : out(out) {}
+
+    void write(int code, int size) {
+        bits |= static_cast<quint32>(code) << bitCount;
+        bitCount += size;
+        while (bitCount >= 8) {
+            block.append(static_cast<char>(bits & 0xff));
+            bits >>= 8;
+            bitCount -= 8;
+            if (block.size() == 255) {
+                flushBlock();
+            }
+        }
+    }
+
+    void finish() {
+        if (bitCount > 0) {
+            block.append(static_cast<char>(bits & 0xff));
+            bits = 0;
+            bitCount = 0;
+        }
+        flushBlock();
+        out.append('\0'); // block terminator
+    }
+
+private:
+    void flushBlock() {
+        if (!block.isEmpty()) {
+            out.append(static_cast<char>(block.size()));
+            out.append(block);
+            block.clear();
+        }
+    }
+
+    QByteArray &out;
+    QByteArray block;
+    quint32 bits = 0;
+    int bitCount = 0;
+};
+
+} // namespace
+
+QByteArray header(int width, int height, const QVector<QRgb> &palette) {
+    const int bits = paletteBits(palette.size());
+    QByteArray out("GIF89a");
+    appendWord(out, width);
+    appendWord(out, height);
+    out.append(static_cast<char>(0x80 | (bits - 1))); // global color table of 2^bits entries
+    out.append('\0');                                 // background color index
+    out.append('\0');                                 // pixel aspect ratio
+
+    for (int i = 0; i < (1 << bits); ++i) {
+        QRgb color = i < palette.size() ? palette[i] : qRgb(0, 0, 0);
+        out.append(static_cast<char>(qRed(color)));
+        out.append(static_cast<char>(qGreen(color)));
+        out.append(static_cast<char>(qBlue(color)));
+    }
+
+    // NETSCAPE2.0 application extension: loop forever
+    out.append("\x21\xff\x0bNETSCAPE2.0\x03\x01", 16);
+    appendWord(out, 0);
+    out.append('\0');
+    return out;
+}
+
+QByteArray frame(const uchar *indices, int width, int height, int bytesPerLine,
+                 int delayCentiseconds, int paletteSize) {
+    QByteArray out;
+
+    // Graphic control extension with the frame delay
+    out.append("\x21\xf9\x04\x00", 4);
+    appendWord(out, delayCentiseconds);
+    out.append('\0'); // transparent color index (unused)
+    out.append('\0');
+
+    // Image descriptor covering the whole canvas, no local color table
+    out.append('\x2c');
+    appendWord(out, 0);
+    appendWord(out, 0);
+    appendWord(out, width);
+    appendWord(out, height);
+    out.append('\0');
+
+    // LZW with a trie over the palette indices, the dictionary is reset when
+    // it reaches 4096 codes
+    const int minCodeSize = paletteBits(paletteSize);
+    const int alphabet = 1 << minCodeSize;
+    const int clearCode = alphabet;
+    out.append(static_cast<char>(minCodeSize));
+
+    std::vector<short> next(4096 * alphabet, -1);
+    int codeSize = minCodeSize + 1;
+    int maxCode = clearCode + 1;
+    CodeWriter writer(out);
+    writer.write(clearCode, codeSize);
+
+    int current = -1;
+    for (int y = 0; y < height; ++y) {
+        const uchar *row = indices + static_cast<qsizetype>(y) * bytesPerLine;
+        for (int x = 0; x < width; ++x) {
+            int value = row[x] & (alphabet - 1);
+            if (current < 0) {
+                current = value;
+                continue;
+            }
+            short &child = next[current * alphabet + value];
+            if (child >= 0) {
+                current = child;
+                continue;
+            }
+
+            writer.write(current, codeSize);
+            child = static_cast<short>(++maxCode);
+            if (maxCode >= (1 << codeSize)) {
+                codeSize++;
+            }
+            if (maxCode == 4095) {
+                writer.write(clearCode, codeSize);
+                std::fill(next.begin(), next.end(), -1);
+                codeSize = minCodeSize + 1;
+                maxCode = clearCode + 1;
+            }
+            current = value;
+        }
+    }
+
+    if (current >= 0) {
+        writer.write(current, codeSize);
+    }
+    // The decoder adds one more dictionary entry on the last code, so the end
+    // of information code may already need the wider code size
+    if (maxCode + 1 >= (1 << codeSize) && codeSize < 12) {
+        codeSize++;
+    }
+    writer.write(clearCode + 1, codeSize); // end of information
+    writer.finish();
+    return out;
+}
+
+bool decodeFrame(const QByteArray &frame, int width, int height, QByteArray *indices) {
+    // Graphic control extension (8 bytes), image descriptor (10 bytes), code size
+    if (frame.size() < 19 || static_cast<uchar>(frame[0]) != 0x21 || static_cast<uchar>(frame[8]) != 0x2c) {
+        return false;
+    }
+    int pos = 18;
+    const int minCodeSize = static_cast<uchar>(frame[pos++]);
+    if (minCodeSize < 2 || minCodeSize > 8) {
+        return false;
+    }
+
+    // Concatenate the data sub-blocks
+    QByteArray data;
+    while (pos < frame.size()) {
+        int length = static_cast<uchar>(frame[pos++]);
+        if (length == 0) {
+            break;
+        }
+        if (pos + length > frame.size()) {
+            return false;
+        }
+        data.append(frame.mid(pos, length));
+        pos += length;
+    }
+
+    const int clearCode = 1 << minCodeSize;
+    std::vector<int> prefix(4096, -1);
+    std::vector<uchar> suffix(4096), first(4096);
+    for (int i = 0; i < clearCode; ++i) {
+        suffix[i] = static_cast<uchar>(i);
+        first[i] = static_cast<uchar>(i);
+    }
+
+    int codeSize = minCodeSize + 1;
+    int next = clearCode + 2;
+    int previous = -1;
+    qint64 bit = 0;
+    const qint64 totalBits = static_cast<qint64>(data.size()) * 8;
+    QByteArray string;
+    indices->clear();
+
+    while (bit + codeSize <= totalBits) {
+        int code = 0;
+        for (int b = 0; b < codeSize; ++b, ++bit) {
+            code |= ((static_cast<uchar>(data[static_cast<int>(bit >> 3)]) >> (bit & 7)) & 1) << b;
+        }
+        if (code == clearCode) {
+            codeSize = minCodeSize + 1;
+            next = clearCode + 2;
+            previous = -1;
+            continue;
+        }
+        if (code == clearCode + 1) {
+            return indices->size() == static_cast<qint64>(width) * height;
+        }
+        if (code > next || (code == next && previous < 0)) {
+            return false;
+        }
+
+        if (previous >= 0 && next < 4096) {
+            prefix[next] = previous;
+            suffix[next] = code == next ? first[previous] : first[code];
+            first[next] = first[previous];
+            next++;
+            if (next == (1 << codeSize) && codeSize < 12) {
+                codeSize++;
+            }
+        }
+
+        // Walk the prefix chain back to the root, then reverse
+        string.clear();
+        for (int c = code; c >= 0; c = prefix[c]) {
+            string.append(static_cast<char>(suffix[c]));
+        }
+        std::reverse(string.begin(), string.end());
+        indices->append(string);
+        previous = code;
+    }
+    return false; // no end of information code
+}
+
+QByteArray trailer() {
+    return QByteArray(1, '\x3b');
+}
+
+} // namespace GifWriter
@@ -0,0 +1,25 @@
+#ifndef GIFWRITER_H
+#define GIFWRITER_H
+
+#include <QByteArray>
+#include <QRgb>
+#include <QVector>
+
+// Minimal animated GIF89a encoder (Qt can read GIF but not write it). Frames
+// are 8-bit palette indices into a global color table of up to 256 colors and
+// are compressed independently, so they can be encoded on worker threads and
+// concatenated in order: header(), frame() for every frame, trailer().
+namespace GifWriter {
+
+QByteArray header(int width, int height, const QVector<QRgb> &palette);
+QByteArray frame(const uchar *indices, int width, int height, int bytesPerLine,
+                 int delayCentiseconds, int paletteSize);
+QByteArray trailer();
+
+// Decodes the image data of one frame() back into width * height palette
+// indices, false if the data is malformed. Lets debug builds check the encoder.
+bool decodeFrame(const QByteArray &frame, int width, int height, QByteArray *indices);
+
+} // namespace GifWriter
+
+#endif // GIFWRITER_H
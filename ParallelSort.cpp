@@ -0,0 +1,281 @@
+#include "ParallelSort.h"
+#include <QElapsedTimer>
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <thread>
+
+namespace ParallelSort {
+
+namespace {
+
+const int kMaxBuckets = 1024;      // bucket ids (up to 2 * kMaxBuckets with equality buckets) are stored as quint16
+const int kMinBucketSize = 4096;   // below this a bucket is not worth a thread hand-off
+const int kOversampling = 32;      // sample elements drawn per bucket
+
+int nextPowerOfTwo(int value) {
+    int result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+int resolveThreads(int threads, int n) {
+    if (threads <= 0) {
+        threads = defaultThreadCount();
+    }
+    // Never hand out fewer than one block of kMinBucketSize elements per thread
+    return std::max(1, std::min(threads, n / kMinBucketSize + 1));
+}
+
+int resolveBuckets(int buckets, int threads, int n) {
+    if (buckets <= 0) {
+        // Enough buckets for the workers to balance, without making them tiny
+        buckets = std::min(threads * 16, n / kMinBucketSize);
+    }
+    return std::min(kMaxBuckets, std::max(2, nextPowerOfTwo(buckets)));
+}
+
+// Splitter tree over the m distinct splitters, padded with the largest one to
+// a power of two and stored in-order as an implicit binary tree at
+// tree[1 .. leaves - 1]. Descending from the root with j = 2 * j + (x > tree[j])
+// for log2(leaves) levels lands on j = leaves + b, where b is the number of
+// splitters smaller than x.
+//
+// When two adjacent splitters are equal the input has heavy duplicates, so
+// every splitter also gets an equality bucket: bucket 2b holds the values
+// between splitters b - 1 and b, bucket 2b + 1 the values equal to splitter b.
+// Equality buckets are already sorted, a value repeated across most of the
+// input therefore costs one classification pass instead of one huge bucket.
+class SplitterTree {
+public:
+    explicit SplitterTree(const QVector<int> &sortedSplitters, bool forceEqualityBuckets = false)
+        : splitters(sortedSplitters.begin(), sortedSplitters.end()) {
+        splitters.erase(std::unique(splitters.begin(), splitters.end()), splitters.end());
+        equalityBuckets = forceEqualityBuckets || static_cast<int>(splitters.size()) < sortedSplitters.size();
+        m = static_cast<int>(splitters.size());
+
+        leaves = nextPowerOfTwo(m + 1);
+        levels = 0;
+        while ((1 << levels) < leaves) {
+            ++levels;
+        }
+        std::vector<int> padded(splitters);
+        padded.resize(leaves - 1, splitters.back());
+        tree.resize(leaves);
+        build(padded, 1, 0, leaves - 2);
+    }
+
+    int classify(int value) const {
+        int j = 1;
+        for (int level = 0; level < levels; ++level) {
+            j = 2 * j + (value > tree[j]);
+        }
+        int bucket = std::min(j - leaves, m); // padding splitters add no buckets
+        if (!equalityBuckets) {
+            return bucket;
+        }
+        return 2 * bucket + ((bucket < m) & (value == splitters[std::min(bucket, m - 1)]));
+    }
+
+    int bucketCount() const { return equalityBuckets ? 2 * m + 1 : m + 1; }
+    bool isEqualityBucket(int bucket) const { return equalityBuckets && bucket % 2 == 1; }
+
+private:
+    void build(const std::vector<int> &sorted, int node, int lo, int hi) {
+        if (lo > hi) {
+            return;
+        }
+        int mid = lo + (hi - lo) / 2;
+        tree[node] = sorted[mid];
+        build(sorted, 2 * node, lo, mid - 1);
+        build(sorted, 2 * node + 1, mid + 1, hi);
+    }
+
+    std::vector<int> splitters; // distinct, ascending
+    std::vector<int> tree;
+    bool equalityBuckets;
+    int m;
+    int leaves;
+    int levels;
+};
+
+// The shared classification core: per-thread classification and histogram,
+// prefix sum over (bucket, thread) and a parallel scatter into a new buffer.
+Partition distribute(QVector<int> &data, const SplitterTree &splitterTree, int threads) {
+    QElapsedTimer timer;
+    timer.start();
+
+    const int n = data.size();
+    const int k = splitterTree.bucketCount();
+    const int *input = data.constData();
+    std::vector<quint16> oracle(n);
+    std::vector<int> histogram(static_cast<size_t>(threads) * k, 0);
+
+    runParallel(threads, [&](int t) {
+        int begin = static_cast<int>(static_cast<qint64>(n) * t / threads);
+        int end = static_cast<int>(static_cast<qint64>(n) * (t + 1) / threads);
+        int *count = &histogram[static_cast<size_t>(t) * k];
+        for (int i = begin; i < end; ++i) {
+            int bucket = splitterTree.classify(input[i]);
+            oracle[i] = static_cast<quint16>(bucket);
+            count[bucket]++;
+        }
+    });
+
+    // Exclusive prefix sum, bucket major so every bucket ends up contiguous
+    Partition partition;
+    partition.bucketStart.resize(k + 1);
+    int offset = 0;
+    for (int b = 0; b < k; ++b) {
+        partition.bucketStart[b] = offset;
+        for (int t = 0; t < threads; ++t) {
+            int count = histogram[static_cast<size_t>(t) * k + b];
+            histogram[static_cast<size_t>(t) * k + b] = offset;
+            offset += count;
+        }
+    }
+    partition.bucketStart[k] = offset;
+    partition.equalityBucket.resize(k);
+    for (int b = 0; b < k; ++b) {
+        partition.equalityBucket[b] = splitterTree.isEqualityBucket(b);
+    }
+
+    QVector<int> output(n);
+    int *out = output.data();
+    runParallel(threads, [&](int t) {
+        int begin = static_cast<int>(static_cast<qint64>(n) * t / threads);
+        int end = static_cast<int>(static_cast<qint64>(n) * (t + 1) / threads);
+        int *next = &histogram[static_cast<size_t>(t) * k];
+        for (int i = begin; i < end; ++i) {
+            out[next[oracle[i]]++] = input[i];
+        }
+    });
+    data.swap(output);
+
+    // Load imbalance across the buckets that still need sorting
+    Stats &stats = partition.stats;
+    stats.threads = threads;
+    stats.buckets = k;
+    stats.equalityBuckets = 0;
+    stats.equalityElements = 0;
+    stats.largestBucket = 0;
+    stats.smallestBucket = n;
+    for (int b = 0; b < k; ++b) {
+        int size = partition.bucketStart[b + 1] - partition.bucketStart[b];
+        if (partition.equalityBucket[b]) {
+            stats.equalityBuckets++;
+            stats.equalityElements += size;
+            continue;
+        }
+        stats.largestBucket = std::max(stats.largestBucket, size);
+        stats.smallestBucket = std::min(stats.smallestBucket, size);
+    }
+    stats.smallestBucket = std::min(stats.smallestBucket, stats.largestBucket);
+    const int sortable = n - stats.equalityElements;
+    stats.imbalance = sortable > 0 ? static_cast<double>(stats.largestBucket) * (k - stats.equalityBuckets) / sortable : 0.0;
+    stats.classifyNs = timer.nsecsElapsed();
+    return partition;
+}
+
+} // namespace
+
+int defaultThreadCount() {
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+Partition sampleDistribute(QVector<int> &data, int threads, int buckets) {
+    const int n = data.size();
+    threads = resolveThreads(threads, n);
+    buckets = resolveBuckets(buckets, threads, n);
+
+    // Oversampled splitters: draw buckets * kOversampling elements with a fixed
+    // seed so runs are reproducible, sort them and take every kOversampling-th
+    QVector<int> sample(buckets * kOversampling);
+    std::mt19937 generator(0x5eed);
+    std::uniform_int_distribution<int> position(0, std::max(0, n - 1));
+    for (int &value : sample) {
+        value = n > 0 ? data[position(generator)] : 0;
+    }
+    std::sort(sample.begin(), sample.end());
+
+    QVector<int> splitters(buckets - 1);
+    for (int i = 0; i < buckets - 1; ++i) {
+        splitters[i] = sample[(i + 1) * kOversampling - 1];
+    }
+    return distribute(data, SplitterTree(splitters), threads);
+}
+
+Partition bucketDistribute(QVector<int> &data, int threads, int buckets) {
+    const int n = data.size();
+    threads = resolveThreads(threads, n);
+    buckets = resolveBuckets(buckets, threads, n);
+
+    int minValue = n > 0 ? *std::min_element(data.constBegin(), data.constEnd()) : 0;
+    int maxValue = n > 0 ? *std::max_element(data.constBegin(), data.constEnd()) : 0;
+
+    // Fewer distinct values than buckets: one equality bucket per value
+    qint64 width = static_cast<qint64>(maxValue) - minValue + 1;
+    if (width < buckets) {
+        QVector<int> splitters(static_cast<int>(width));
+        for (int i = 0; i < width; ++i) {
+            splitters[i] = minValue + i;
+        }
+        return distribute(data, SplitterTree(splitters, true), threads);
+    }
+
+    // Evenly spaced splitters over [minValue, maxValue]
+    QVector<int> splitters(buckets - 1);
+    for (int i = 0; i < buckets - 1; ++i) {
+        splitters[i] = static_cast<int>(minValue + width * (i + 1) / buckets - 1);
+    }
+    return distribute(data, SplitterTree(splitters), threads);
+}
+
+void sortBuckets(QVector<int> &data, Partition &partition, int threads) {
+    QElapsedTimer timer;
+    timer.start();
+
+    const QVector<int> &start = partition.bucketStart;
+    const int k = start.size() - 1;
+    threads = resolveThreads(threads, data.size());
+
+    // Largest buckets first, workers pull the next one when they are done;
+    // equality buckets hold a single value and are skipped
+    std::vector<int> order;
+    for (int b = 0; b < k; ++b) {
+        if (!partition.equalityBucket[b]) {
+            order.push_back(b);
+        }
+    }
+    const int pending = static_cast<int>(order.size());
+    std::sort(order.begin(), order.end(), [&start](int a, int b) {
+        return start[a + 1] - start[a] > start[b + 1] - start[b];
+    });
+
+    int *base = data.data();
+    std::atomic<int> next(0);
+    runParallel(threads, [&](int) {
+        for (int i = next++; i < pending; i = next++) {
+            int bucket = order[i];
+            std::sort(base + start[bucket], base + start[bucket + 1]);
+        }
+    });
+
+    partition.stats.sortNs = timer.nsecsElapsed();
+}
+
+Stats sampleSort(QVector<int> &data, int threads) {
+    Partition partition = sampleDistribute(data, threads);
+    sortBuckets(data, partition, threads);
+    return partition.stats;
+}
+
+Stats bucketSort(QVector<int> &data, int threads) {
+    Partition partition = bucketDistribute(data, threads);
+    sortBuckets(data, partition, threads);
+    return partition.stats;
+}
+
+} // namespace ParallelSort
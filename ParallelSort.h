@@ -0,0 +1,74 @@
+#ifndef PARALLELSORT_H
+#define PARALLELSORT_H
+
+#include <QVector>
+#include <thread>
+#include <vector>
+
+// Distribution based parallel sorting engines (sample sort and bucket sort).
+// Both engines share one classification core: a set of splitters is laid out
+// as an implicit binary search tree and every element finds its bucket with a
+// branchless descent, each thread classifies its own block, a prefix sum over
+// the per-thread histograms gives every (bucket, thread) pair its output slot
+// and the buckets are then sorted in parallel. Inputs with heavy duplicates
+// (adjacent equal splitters) get equality buckets that need no sorting.
+namespace ParallelSort {
+
+struct Stats {
+    int threads = 0;
+    int buckets = 0;
+    int equalityBuckets = 0;      // buckets holding a single repeated value, never sorted
+    int equalityElements = 0;
+    int largestBucket = 0;        // largest / smallest bucket that still needs sorting
+    int smallestBucket = 0;
+    double imbalance = 0.0;       // largest bucket to sort / ideal bucket size (1.0 is perfect)
+    qint64 classifyNs = 0;        // classification + scatter
+    qint64 sortNs = 0;            // parallel bucket sorting
+};
+
+// Result of the classification and scatter phase: bucketStart has
+// buckets + 1 entries, bucket b occupies [bucketStart[b], bucketStart[b + 1]).
+struct Partition {
+    QVector<int> bucketStart;
+    QVector<bool> equalityBucket; // already sorted, sortBuckets skips these
+    Stats stats;
+};
+
+// Number of worker threads used when the caller passes threads <= 0.
+int defaultThreadCount();
+
+// Run fn(0) .. fn(threads - 1), worker 0 runs on the calling thread
+template <typename Fn>
+void runParallel(int threads, Fn fn) {
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (int t = 1; t < threads; ++t) {
+        workers.emplace_back(fn, t);
+    }
+    fn(0);
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+}
+
+// Classify and scatter data into buckets delimited by the splitter tree built
+// from the sample (sample sort) or from evenly spaced values (bucket sort).
+// Elements are moved so that every bucket is contiguous; buckets are not
+// sorted yet. buckets is rounded up to a power of two, 0 picks a count from
+// the input size and the number of threads; equal splitters are merged and
+// add equality buckets instead.
+Partition sampleDistribute(QVector<int> &data, int threads = 0, int buckets = 0);
+Partition bucketDistribute(QVector<int> &data, int threads = 0, int buckets = 0);
+
+// Sort every bucket of an already distributed array, buckets are handed out
+// to the workers largest first so a single heavy bucket does not stall the
+// others.
+void sortBuckets(QVector<int> &data, Partition &partition, int threads = 0);
+
+// Full sorts: distribute followed by sortBuckets.
+Stats sampleSort(QVector<int> &data, int threads = 0);
+Stats bucketSort(QVector<int> &data, int threads = 0);
+
+} // namespace ParallelSort
+
+#endif // PARALLELSORT_H
@@ -1,5 +1,6 @@
 #include "SortingVisualizer.h"
 #include <QCoreApplication>
+#include <QApplication>
 #include <QHBoxLayout>
 #include <QBrush>
 #include <QColor>
@@ -8,6 +9,9 @@
 #include <QFile>
 #include <QTextStream>
 #include <QDebug>
+#include "Workload.h"
+#include <algorithm>
+#include <cmath>
 
 
 
@@ -63,10 +67,46 @@ SortingVisualizer::SortingVisualizer(QWidget *parent) : QMainWindow(parent), tim
     });
     controlsLayout->addWidget(uploadFileButton);
 
+    // Generated datasets from the same catalog the benchmarks use
+    QHBoxLayout *datasetLayout = new QHBoxLayout();
+    QComboBox *datasetBox = new QComboBox(this);
+    for (const Workload::Spec &spec : Workload::catalog()) {
+        if (spec.size <= 1000) { // Larger datasets are for the headless benchmarks
+            datasetBox->addItem(spec.name);
+        }
+    }
+    QPushButton *loadDatasetButton = new QPushButton("Load Dataset", this);
+    connect(loadDatasetButton, &QPushButton::clicked, this, [inputField, datasetBox]() {
+        const Workload::Spec *spec = Workload::find(datasetBox->currentText());
+        if (spec) {
+            QVector<int> values;
+            Workload::generate(*spec, values);
+            QStringList text;
+            for (int value : values) {
+                text.append(QString::number(value));
+            }
+            inputField->setText(text.join(", ")); // Same format as numbers.txt
+        }
+    });
+    datasetLayout->addWidget(datasetBox);
+    datasetLayout->addWidget(loadDatasetButton);
+    controlsLayout->addLayout(datasetLayout);
+
     QStringList algorithms = {"Bubble Sort", "Insertion Sort", "Selection Sort",
                               "Merge Sort", "Quick Sort", "Heap Sort",
                               "Counting Sort", "Radix Sort", "Shell Sort",
-                              "Bucket Sort"};
+                              "Bucket Sort", "Sample Sort", "Parallel Bucket Sort",
+                              "Nth Element", "Top-K (Heap)", "Partial Quick Sort"};
+
+    // k for the selection engines: the k-th smallest, or the k smallest
+    QHBoxLayout *kLayout = new QHBoxLayout();
+    QLabel *kLabel = new QLabel("k (selection engines):");
+    kBox = new QSpinBox(this);
+    kBox->setRange(1, 1000000);
+    kBox->setValue(10);
+    kLayout->addWidget(kLabel);
+    kLayout->addWidget(kBox);
+    controlsLayout->addLayout(kLayout);
 
     for (const QString &algo : algorithms) {
         QPushButton *button = new QPushButton(algo, this);
@@ -120,6 +160,54 @@ SortingVisualizer::SortingVisualizer(QWidget *parent) : QMainWindow(parent), tim
     controlsLayout->addWidget(playButton);
     controlsLayout->addWidget(pauseButton);
 
+    // Streaming input: a bounded window kept sorted as values arrive
+    QHBoxLayout *streamLayout = new QHBoxLayout();
+    QLabel *windowSizeLabel = new QLabel("Stream window size:");
+    windowSizeBox = new QSpinBox(this);
+    windowSizeBox->setRange(4, 4096);
+    windowSizeBox->setValue(64);
+    QPushButton *streamFileButton = new QPushButton("Stream File", this);
+    QPushButton *streamStdinButton = new QPushButton("Stream stdin", this);
+    QPushButton *stopStreamButton = new QPushButton("Stop Stream", this);
+    connect(streamFileButton, &QPushButton::clicked, this, [this]() {
+        // Regular files are tailed, named pipes are read until the writer closes them
+        QString fileName = QFileDialog::getOpenFileName(this, "Stream From File or Pipe");
+        if (!fileName.isEmpty()) {
+            startStream(fileName);
+        }
+    });
+    connect(streamStdinButton, &QPushButton::clicked, this, [this]() { startStream("-"); });
+    connect(stopStreamButton, &QPushButton::clicked, this, &SortingVisualizer::stopStream);
+    streamLayout->addWidget(windowSizeLabel);
+    streamLayout->addWidget(windowSizeBox);
+    streamLayout->addWidget(streamFileButton);
+    streamLayout->addWidget(streamStdinButton);
+    streamLayout->addWidget(stopStreamButton);
+    controlsLayout->addLayout(streamLayout);
+
+    // Offline export of the current run to a GIF or PNG sequence
+    QHBoxLayout *exportLayout = new QHBoxLayout();
+    resolutionBox = new QComboBox(this);
+    resolutionBox->addItems({"640x360", "1280x720", "1920x1080"});
+    resolutionBox->setCurrentIndex(1);
+    fpsBox = new QSpinBox(this);
+    fpsBox->setRange(1, 60);
+    fpsBox->setValue(25);
+    fpsBox->setSuffix(" fps");
+    fpsBox->setToolTip(QString("GIF exports are capped at %1 fps").arg(FrameExporter::kMaxGifFps));
+    durationBox = new QSpinBox(this);
+    durationBox->setRange(0, 3600);
+    durationBox->setValue(20);
+    durationBox->setSuffix(" s");
+    durationBox->setSpecialValueText("every step"); // 0 exports one frame per step
+    QPushButton *exportButton = new QPushButton("Export Video", this);
+    connect(exportButton, &QPushButton::clicked, this, &SortingVisualizer::exportVideo);
+    exportLayout->addWidget(resolutionBox);
+    exportLayout->addWidget(fpsBox);
+    exportLayout->addWidget(durationBox);
+    exportLayout->addWidget(exportButton);
+    controlsLayout->addLayout(exportLayout);
+
     controlsWidget->setLayout(controlsLayout);
     splitter->addWidget(controlsWidget);
     setCentralWidget(splitter);
@@ -197,6 +285,7 @@ QVector<int> SortingVisualizer::getInputArray(const QString &input) {
 }
 
 void SortingVisualizer::visualizeAlgorithm(const QString &algorithm, const QString &input) {
+    stopStream(); // a running stream would keep drawing over the new scene
     array = getInputArray(input);
 
     if (array.isEmpty()) {
@@ -218,6 +307,9 @@ void SortingVisualizer::visualizeAlgorithm(const QString &algorithm, const QStri
     steps.clear();
     highlights.clear();
     currentStep = 0;
+    comparisons = 0;
+    swaps = 0;
+    const QVector<int> input = array;
 
     if (algorithm == "Bubble Sort") {
         bubbleSort();
@@ -239,7 +331,25 @@ void SortingVisualizer::visualizeAlgorithm(const QString &algorithm, const QStri
         shellSort();
     } else if (algorithm == "Bucket Sort") {
         bucketSort();
+    } else if (algorithm == "Sample Sort") {
+        sampleSort();
+    } else if (algorithm == "Parallel Bucket Sort") {
+        parallelBucketSort();
+    } else if (algorithm == "Nth Element") {
+        steps.push_back(array); // Initial state
+        int depthLimit = 2 * static_cast<int>(std::log2(array.size()) + 1);
+        nthElement(0, array.size() - 1, selectionK() - 1, depthLimit);
+        steps.push_back(array); // Final state
+    } else if (algorithm == "Top-K (Heap)") {
+        topKHeap(selectionK());
+    } else if (algorithm == "Partial Quick Sort") {
+        steps.push_back(array); // Initial state
+        partialQuickSort(0, array.size() - 1, selectionK());
+        steps.push_back(array); // Final state
     }
+
+    bool isSelection = algorithm == "Nth Element" || algorithm == "Top-K (Heap)" || algorithm == "Partial Quick Sort";
+    reportCounters(algorithm, input, isSelection);
 }
 
 void SortingVisualizer::updateVisualization() {
@@ -261,6 +371,10 @@ void SortingVisualizer::updateVisualization() {
 
 
 void SortingVisualizer::play() {
+    if (streamReader) {
+        statusBar()->showMessage("Stop the stream before playing a recorded run");
+        return;
+    }
     if (!isPlaying) {
         isPlaying = true;
         timer->start(300); // Set timer interval to 1500 ms
@@ -275,6 +389,7 @@ void SortingVisualizer::pause() {
 }
 
 void SortingVisualizer::resetVisualization() {
+    stopStream();
     array.clear();
     steps.clear();
     highlights.clear();
@@ -284,6 +399,114 @@ void SortingVisualizer::resetVisualization() {
     isPlaying = false; // Update playing status
 }
 
+void SortingVisualizer::startStream(const QString &source) {
+    stopStream();
+    pause();
+
+    scene = new QGraphicsScene(this);
+    graphicsView->setScene(scene);
+    isBarVisualization = true;
+    graphicsView->setFixedHeight(300);
+
+    streamWindow = StreamWindow(windowSizeBox->value());
+    streamClock.start();
+    lastStreamDraw.invalidate();
+
+    // Batches of a quarter window keep every batch visible on screen
+    streamReader = new StreamReader(source, qMax(1, windowSizeBox->value() / 4), this);
+    connect(streamReader, &StreamReader::batchReady, this, &SortingVisualizer::appendStreamBatch);
+    connect(streamReader, &StreamReader::streamError, this, [this](const QString &message) {
+        if (streamReader && sender() == streamReader) {
+            statusBar()->showMessage(message);
+        }
+    });
+    streamReader->start();
+    statusBar()->showMessage("Streaming from " + (source == "-" ? QString("stdin") : source));
+}
+
+void SortingVisualizer::stopStream() {
+    if (streamReader) {
+        disconnect(streamReader, nullptr, this, nullptr); // drop batches still queued for the old scene
+        streamReader->stop();
+        streamReader->deleteLater();
+        streamReader = nullptr;
+    }
+}
+
+void SortingVisualizer::appendStreamBatch(const QVector<int> &batch) {
+    if (!streamReader || sender() != streamReader) {
+        return; // queued before the stream was stopped
+    }
+    StreamWindow::BatchResult result = streamWindow.push(batch);
+    const QVector<int> &window = streamWindow.values();
+
+    // Red marks the newest insertion, green where the last eviction happened
+    if (!window.isEmpty() && (!lastStreamDraw.isValid() || lastStreamDraw.elapsed() >= 30)) {
+        int inserted = result.insertedAt.isEmpty() ? -1 : result.insertedAt.last();
+        int evicted = result.evictedAt.isEmpty() ? -1 : qMin(result.evictedAt.last(), window.size() - 1);
+        drawArray(window, inserted, evicted);
+        lastStreamDraw.start();
+    }
+
+    double seconds = qMax<qint64>(1, streamClock.elapsed()) / 1000.0;
+    statusBar()->showMessage(QString("Streaming: %1 values, window %2/%3, %4 values/s, batch latency last %5 us, avg %6 us, max %7 us")
+                                 .arg(streamWindow.totalValues())
+                                 .arg(streamWindow.size())
+                                 .arg(streamWindow.capacity())
+                                 .arg(streamWindow.totalValues() / seconds, 0, 'f', 0)
+                                 .arg(result.latencyNs / 1000)
+                                 .arg(streamWindow.averageLatencyNs() / 1000)
+                                 .arg(streamWindow.maxLatencyNs() / 1000));
+}
+
+bool SortingVisualizer::recordTrace(const QString &algorithm, const QString &input) {
+    visualizeAlgorithm(algorithm, input);
+    return !steps.isEmpty();
+}
+
+bool SortingVisualizer::exportFrames(const FrameExporter::Options &options, FrameExporter::Result *result, QString *error) const {
+    return FrameExporter::exportTrace(steps, highlights, options, result, error);
+}
+
+void SortingVisualizer::exportVideo() {
+    if (steps.isEmpty()) {
+        statusBar()->showMessage("Run an algorithm first, then export it");
+        return;
+    }
+
+    QString fileName = QFileDialog::getSaveFileName(this, "Export Video", "", "Animated GIF (*.gif);;PNG image sequence (*.png)");
+    if (fileName.isEmpty()) {
+        return;
+    }
+    pause();
+
+    FrameExporter::Options options;
+    options.path = fileName;
+    options.format = FrameExporter::formatForPath(fileName);
+    QStringList resolution = resolutionBox->currentText().split('x');
+    options.width = resolution[0].toInt();
+    options.height = resolution[1].toInt();
+    options.fps = fpsBox->value();
+    options.seconds = durationBox->value();
+
+    FrameExporter::Result result;
+    QString error;
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    bool exported = exportFrames(options, &result, &error);
+    QApplication::restoreOverrideCursor();
+
+    if (exported) {
+        statusBar()->showMessage(QString("Exported %1 frames at %2 fps from %3 steps in %4 ms to %5")
+                                     .arg(result.frames)
+                                     .arg(result.fps)
+                                     .arg(result.steps)
+                                     .arg(result.elapsedMs)
+                                     .arg(fileName));
+    } else {
+        statusBar()->showMessage(error);
+    }
+}
+
 void SortingVisualizer::drawArray(const QVector<int> &array, int highlightIndex1, int highlightIndex2) {
     scene->clear();
 
@@ -292,7 +515,7 @@ void SortingVisualizer::drawArray(const QVector<int> &array, int highlightIndex1
 
     // Check whether to draw boxes or bars
     if (isBarVisualization) {
-        int maxElement = *std::max_element(array.begin(), array.end());
+        int maxElement = qMax(1, *std::max_element(array.begin(), array.end()));
 
         for (int i = 0; i < arraySize; ++i) {
             // If no elements are being highlighted, the sorting is complete, so color everything yellow
@@ -442,14 +665,17 @@ int SortingVisualizer::partition(int left, int right) {
     int i = left - 1;
 
     for (int j = left; j < right; j++) {
+        comparisons++;
         if (array[j] < pivot) {
             i++;
             std::swap(array[i], array[j]);
+            swaps++;
             steps.push_back(array); // Store each step
             highlights.append({i, j}); // Highlight indices
         }
     }
     std::swap(array[i + 1], array[right]);
+    swaps++;
     steps.push_back(array); // Store each step
     highlights.append({i + 1, right}); // Highlight indices
     return i + 1;
@@ -485,18 +711,25 @@ void SortingVisualizer::heapify(QVector<int> &array, int n, int root) {
     int right = 2 * root + 2; // right = 2*i + 2
 
     // Check if left child exists and is greater than root
-    if (left < n && array[left] > array[largest]) {
-        largest = left;
+    if (left < n) {
+        comparisons++;
+        if (array[left] > array[largest]) {
+            largest = left;
+        }
     }
 
     // Check if right child exists and is greater than largest so far
-    if (right < n && array[right] > array[largest]) {
-        largest = right;
+    if (right < n) {
+        comparisons++;
+        if (array[right] > array[largest]) {
+            largest = right;
+        }
     }
 
     // If largest is not root, swap it with root
     if (largest != root) {
         std::swap(array[root], array[largest]);
+        swaps++;
         steps.push_back(array); // Store the current state after swap
         highlights.append({root, largest}); // Highlight indices
         // Recursively heapify the affected sub-tree
@@ -631,3 +864,191 @@ void SortingVisualizer::bucketSort() {
 
     steps.push_back(array); // Store final state
 }
+
+// Sample Sort
+void SortingVisualizer::sampleSort() {
+    steps.push_back(array); // Initial state
+    ParallelSort::Partition partition = ParallelSort::sampleDistribute(array, 0, 8);
+    recordDistribution("Sample Sort", partition);
+}
+
+// Parallel Bucket Sort
+void SortingVisualizer::parallelBucketSort() {
+    steps.push_back(array); // Initial state
+    ParallelSort::Partition partition = ParallelSort::bucketDistribute(array, 0, 8);
+    recordDistribution("Parallel Bucket Sort", partition);
+}
+
+void SortingVisualizer::recordDistribution(const QString &name, ParallelSort::Partition &partition) {
+    const QVector<int> &start = partition.bucketStart;
+    QVector<int> scattered = array;
+
+    // Show every bucket after classification and scatter
+    for (int b = 0; b + 1 < start.size(); ++b) {
+        if (start[b] < start[b + 1]) {
+            steps.push_back(scattered);
+            highlights.append({start[b], start[b + 1] - 1}); // Highlight the bucket boundaries
+        }
+    }
+
+    // The buckets are sorted in parallel, replay them one at a time
+    ParallelSort::sortBuckets(array, partition);
+    for (int b = 0; b + 1 < start.size(); ++b) {
+        if (start[b] < start[b + 1]) {
+            std::copy(array.begin() + start[b], array.begin() + start[b + 1], scattered.begin() + start[b]);
+            steps.push_back(scattered); // Store the state after each bucket is sorted
+            highlights.append({start[b], start[b + 1] - 1});
+        }
+    }
+
+    steps.push_back(array); // Store final state
+
+    const ParallelSort::Stats &stats = partition.stats;
+    statusBar()->showMessage(QString("%1: %2 buckets (%3 equality) on %4 threads, largest %5, smallest %6, imbalance %7")
+                                 .arg(name)
+                                 .arg(stats.buckets)
+                                 .arg(stats.equalityBuckets)
+                                 .arg(stats.threads)
+                                 .arg(stats.largestBucket)
+                                 .arg(stats.smallestBucket)
+                                 .arg(stats.imbalance, 0, 'f', 2));
+}
+
+// Selection engines: answer "the k-th smallest" or "the k smallest" without
+// sorting everything, built on the same partition/heapify as the full sorts.
+
+// k from the spin box, clamped to the input size
+int SortingVisualizer::selectionK() const {
+    return qBound(1, kBox->value(), static_cast<int>(array.size()));
+}
+
+int SortingVisualizer::medianOfThree(int a, int b, int c) {
+    comparisons++;
+    if (array[a] < array[b]) {
+        comparisons++;
+        if (array[b] < array[c]) {
+            return b;
+        }
+        comparisons++;
+        return array[a] < array[c] ? c : a;
+    }
+    comparisons++;
+    if (array[a] < array[c]) {
+        return a;
+    }
+    comparisons++;
+    return array[b] < array[c] ? c : b;
+}
+
+// Nth Element (introselect with Floyd-Rivest pivot sampling)
+void SortingVisualizer::nthElement(int left, int right, int k, int depthLimit) {
+    while (left < right) {
+        if (depthLimit-- <= 0) {
+            // Too many bad pivots, finish the range with a guaranteed O(n log n) sort
+            std::sort(array.begin() + left, array.begin() + right + 1, [this](int a, int b) {
+                comparisons++;
+                return a < b;
+            });
+            steps.push_back(array); // Store the state after the fallback
+            highlights.append({left, right});
+            return;
+        }
+
+        int pivotIndex;
+        if (right - left > 600) {
+            // Floyd-Rivest: select k inside a small range around its expected
+            // position first, the element landing at k is then a very good pivot
+            double n = right - left + 1;
+            double i = k - left + 1;
+            double z = std::log(n);
+            double s = 0.5 * std::exp(2 * z / 3);
+            double sd = 0.5 * std::sqrt(z * s * (n - s) / n) * (i < n / 2 ? -1 : 1);
+            int sampleLeft = std::max(left, static_cast<int>(k - i * s / n + sd));
+            int sampleRight = std::min(right, static_cast<int>(k + (n - i) * s / n + sd));
+            nthElement(sampleLeft, sampleRight, k, depthLimit);
+            pivotIndex = k;
+        } else {
+            pivotIndex = medianOfThree(left, left + (right - left) / 2, right);
+        }
+
+        std::swap(array[pivotIndex], array[right]); // partition() pivots on the last element
+        swaps++;
+        int split = partition(left, right);
+        if (split == k) {
+            return;
+        } else if (k < split) {
+            right = split - 1;
+        } else {
+            left = split + 1;
+        }
+    }
+}
+
+// Top-K (bounded max-heap holding the k smallest seen so far)
+void SortingVisualizer::topKHeap(int k) {
+    QVector<int> tempArray = array;
+    steps.push_back(tempArray); // Store initial state
+    int n = tempArray.size();
+
+    // Build a max-heap over the first k elements
+    for (int i = k / 2 - 1; i >= 0; i--) {
+        heapify(tempArray, k, i);
+    }
+
+    // Anything smaller than the heap root replaces it
+    for (int i = k; i < n; i++) {
+        comparisons++;
+        if (tempArray[i] < tempArray[0]) {
+            std::swap(tempArray[0], tempArray[i]);
+            swaps++;
+            steps.push_back(tempArray); // Store each step after replacing the root
+            highlights.append({0, i}); // Highlight the root and the incoming element
+            heapify(tempArray, k, 0);
+        }
+    }
+
+    // Sort the k smallest in place by extracting from the heap
+    for (int i = k - 1; i > 0; i--) {
+        std::swap(tempArray[0], tempArray[i]);
+        swaps++;
+        steps.push_back(tempArray); // Store each step after swapping
+        highlights.append({0, i}); // Highlight the swapped elements
+        heapify(tempArray, i, 0);
+    }
+
+    array = tempArray; // Update the original array, first k are the k smallest in order
+    steps.push_back(array); // Store the final state
+}
+
+// Partial Quick Sort (only recurses into ranges that overlap the first k)
+void SortingVisualizer::partialQuickSort(int left, int right, int k) {
+    if (left < right) {
+        int pivotIndex = partition(left, right);
+        partialQuickSort(left, pivotIndex - 1, k);
+        if (pivotIndex < k - 1) {
+            partialQuickSort(pivotIndex + 1, right, k);
+        }
+    }
+}
+
+void SortingVisualizer::reportCounters(const QString &algorithm, const QVector<int> &input, bool isSelection) {
+    if (comparisons == 0 && swaps == 0) {
+        return; // Engine is not instrumented
+    }
+
+    QString message = QString("%1: %2 comparisons, %3 swaps").arg(algorithm).arg(comparisons).arg(swaps);
+    if (isSelection) {
+        // Compare against sorting everything with std::sort
+        qint64 sortComparisons = 0;
+        QVector<int> sorted = input;
+        std::sort(sorted.begin(), sorted.end(), [&sortComparisons](int a, int b) {
+            sortComparisons++;
+            return a < b;
+        });
+        message += QString(", k=%1; a full sort needs %2 comparisons (%3% saved)")
+                       .arg(selectionK())
+                       .arg(sortComparisons)
+                       .arg(sortComparisons > 0 ? 100.0 * (sortComparisons - comparisons) / sortComparisons : 0.0, 0, 'f', 0);
+    }
+    statusBar()->showMessage(message);
+}
@@ -19,6 +19,14 @@
 #include <QStringList>
 #include <QSplitter>
 #include <QPair>
+#include <QStatusBar>
+#include <QSpinBox>
+#include <QElapsedTimer>
+#include <QComboBox>
+#include "ParallelSort.h"
+#include "StreamWindow.h"
+#include "StreamReader.h"
+#include "FrameExporter.h"
 
 class SortingVisualizer : public QMainWindow {
     Q_OBJECT
@@ -26,12 +34,20 @@ class SortingVisualizer : public QMainWindow {
 public:
     SortingVisualizer(QWidget *parent = nullptr);
 
+    // Headless use: record the trace of one run, then export it offline
+    bool recordTrace(const QString &algorithm, const QString &input);
+    bool exportFrames(const FrameExporter::Options &options, FrameExporter::Result *result, QString *error) const;
+
 private slots:
     void visualizeAlgorithm(const QString &algorithm, const QString &input);
     void updateVisualization();
     void play();
     void pause();
     void resetVisualization();
+    void startStream(const QString &source);
+    void stopStream();
+    void appendStreamBatch(const QVector<int> &batch);
+    void exportVideo();
 
 private:
     void bubbleSort();
@@ -44,12 +60,21 @@ private:
     void radixSort();
     void shellSort();
     void bucketSort();
+    void sampleSort();
+    void parallelBucketSort();
+    void nthElement(int left, int right, int k, int depthLimit);
+    void topKHeap(int k);
+    void partialQuickSort(int left, int right, int k);
 
     QVector<int> getInputArray(const QString &input);
     void merge(int left, int mid, int right);
     int partition(int left, int right);
+    int medianOfThree(int a, int b, int c);
+    int selectionK() const;
+    void reportCounters(const QString &algorithm, const QVector<int> &input, bool isSelection);
     void heapify(QVector<int>& array, int n, int root);
     void countingSortForRadix(int exp);
+    void recordDistribution(const QString &name, ParallelSort::Partition &partition);
     void drawArray(const QVector<int> &array, int highlightIndex1 = -1, int highlightIndex2 = -1);
     bool isBarVisualization = false;
 
@@ -66,6 +91,23 @@ private:
     QWidget *overlayWidget;
     bool showValues;
 
+    // Work counters for the partition/heapify based engines
+    qint64 comparisons = 0;
+    qint64 swaps = 0;
+    QSpinBox *kBox; // k for the selection engines
+
+    // Offline export settings
+    QComboBox *resolutionBox;
+    QSpinBox *fpsBox;
+    QSpinBox *durationBox;
+
+    // Streaming mode
+    StreamReader *streamReader = nullptr;
+    StreamWindow streamWindow;
+    QSpinBox *windowSizeBox;
+    QElapsedTimer streamClock;    // wall time since the stream started
+    QElapsedTimer lastStreamDraw; // redraws are throttled for fast feeds
+
 };
 
 #endif // SORTINGVISUALIZER_H
@@ -0,0 +1,174 @@
+#include "StreamReader.h"
+#include <QFile>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+
+#ifdef Q_OS_UNIX
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Opens the source for reading, "-" is stdin
+bool openSource(QFile &file, const QString &source, QString *error) {
+    if (source == "-") {
+        if (!file.open(stdin, QIODevice::ReadOnly | QIODevice::Unbuffered)) {
+            *error = file.errorString();
+            return false;
+        }
+        return true;
+    }
+
+#ifdef Q_OS_UNIX
+    // open() on a FIFO blocks until a writer shows up, before run() can see
+    // an interruption request. Open it non-blocking and let the poll loop
+    // wait for the writer instead.
+    const QByteArray path = QFile::encodeName(source);
+    struct stat info;
+    if (::stat(path.constData(), &info) == 0 && S_ISFIFO(info.st_mode)) {
+        int fd = ::open(path.constData(), O_RDONLY | O_NONBLOCK);
+        if (fd < 0) {
+            *error = QString::fromLocal8Bit(std::strerror(errno));
+            return false;
+        }
+        if (!file.open(fd, QIODevice::ReadOnly | QIODevice::Unbuffered, QFileDevice::AutoCloseHandle)) {
+            *error = file.errorString();
+            ::close(fd);
+            return false;
+        }
+        return true;
+    }
+#endif
+
+    file.setFileName(source);
+    if (!file.open(QIODevice::ReadOnly)) {
+        *error = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+StreamReader::StreamReader(const QString &source, int batchSize, QObject *parent)
+    : QThread(parent), source(source), batchSize(qMax(1, batchSize)) {
+    qRegisterMetaType<QVector<int>>("QVector<int>"); // batches cross threads
+}
+
+StreamReader::~StreamReader() {
+    stop();
+}
+
+void StreamReader::stop() {
+    requestInterruption();
+    wait(); // run() checks for the request at least every 100 ms
+}
+
+void StreamReader::run() {
+    QFile file;
+    QString error;
+    if (!openSource(file, source, &error)) {
+        emit streamError("Cannot open " + source + ": " + error);
+        return;
+    }
+
+#ifdef Q_OS_UNIX
+    // Pipes and stdin are polled with a timeout instead of blocking in read(),
+    // so an idle writer cannot keep stop() waiting
+    const int fd = file.isSequential() ? file.handle() : -1;
+    const int flags = fd >= 0 ? fcntl(fd, F_GETFL) : 0;
+    if (fd >= 0) {
+        fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+    }
+#endif
+
+    QByteArray pending; // text after the last separator, may be a partial number
+    QVector<int> batch;
+
+    while (!isInterruptionRequested()) {
+        QByteArray chunk;
+#ifdef Q_OS_UNIX
+        if (fd >= 0) {
+            pollfd request = {fd, POLLIN, 0};
+            int ready = ::poll(&request, 1, 100);
+            if (ready == 0) {
+                continue; // idle, check for stop() again
+            }
+            char buffer[4096];
+            ssize_t count = ready > 0 ? ::read(fd, buffer, sizeof(buffer)) : -1;
+            if (count < 0) {
+                if (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK) {
+                    continue;
+                }
+                emit streamError("Cannot read " + source + ": " + QString::fromLocal8Bit(std::strerror(errno)));
+                break;
+            }
+            chunk = QByteArray(buffer, static_cast<int>(count));
+        } else {
+            chunk = file.read(4096);
+        }
+#else
+        chunk = file.read(4096); // blocks on an idle pipe, stop() waits for the next chunk or the end
+#endif
+        if (chunk.isEmpty()) {
+            if (file.isSequential()) {
+                break; // writer closed the pipe
+            }
+            // End of a regular file, flush what we have and keep tailing
+            if (!batch.isEmpty()) {
+                emit batchReady(batch);
+                batch.clear();
+            }
+            msleep(100);
+            continue;
+        }
+
+        pending.append(chunk);
+        int last = pending.size() - 1;
+        while (last >= 0 && pending[last] != ',' && !std::isspace(static_cast<uchar>(pending[last]))) {
+            last--;
+        }
+        QByteArray complete = pending.left(last + 1);
+        complete.replace(',', ' ');
+        const QList<QByteArray> tokens = complete.simplified().split(' ');
+        pending.remove(0, last + 1);
+
+        for (const QByteArray &token : tokens) {
+            bool ok;
+            int value = token.toInt(&ok);
+            if (ok) {
+                batch.append(value);
+            }
+            if (batch.size() >= batchSize) {
+                emit batchReady(batch);
+                batch.clear();
+            }
+        }
+
+        // Short read means the source is idle, do not hold values back
+        if (chunk.size() < 4096 && !batch.isEmpty()) {
+            emit batchReady(batch);
+            batch.clear();
+        }
+    }
+
+#ifdef Q_OS_UNIX
+    if (fd >= 0) {
+        fcntl(fd, F_SETFL, flags); // stdin is shared with the rest of the process
+    }
+#endif
+
+    bool ok;
+    int value = pending.trimmed().toInt(&ok);
+    if (ok) {
+        batch.append(value);
+    }
+    if (!batch.isEmpty()) {
+        emit batchReady(batch);
+    }
+}
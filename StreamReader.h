@@ -0,0 +1,33 @@
+#ifndef STREAMREADER_H
+#define STREAMREADER_H
+
+#include <QThread>
+#include <QString>
+#include <QVector>
+
+// Reads numbers from a live source on its own thread and hands them to the
+// GUI in batches. The source is a file path (a regular file is tailed, a named
+// pipe is read until the writer closes it) or "-" for stdin. Values may be
+// separated by commas or whitespace.
+class StreamReader : public QThread {
+    Q_OBJECT
+
+public:
+    StreamReader(const QString &source, int batchSize, QObject *parent = nullptr);
+    ~StreamReader() override;
+
+    void stop();
+
+signals:
+    void batchReady(const QVector<int> &batch);
+    void streamError(const QString &message);
+
+protected:
+    void run() override;
+
+private:
+    QString source;
+    int batchSize;
+};
+
+#endif // STREAMREADER_H
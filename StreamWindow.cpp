@@ -0,0 +1,75 @@
+#include "StreamWindow.h"
+#include <QElapsedTimer>
+#include <algorithm>
+
+StreamWindow::StreamWindow(int capacity) : ring(std::max(1, capacity)) {
+    sorted.reserve(ring.size());
+}
+
+void StreamWindow::clear() {
+    head = 0;
+    count = 0;
+    sorted.clear();
+    valuesSeen = 0;
+    batches = 0;
+    totalNs = 0;
+    maxNs = 0;
+}
+
+StreamWindow::BatchResult StreamWindow::push(const QVector<int> &batch) {
+    QElapsedTimer timer;
+    timer.start();
+
+    BatchResult result;
+    const int cap = ring.size();
+    valuesSeen += batch.size();
+
+    // Values older than the last cap of the batch would be evicted by the same batch
+    int skip = std::max(0, static_cast<int>(batch.size()) - cap);
+    QVector<int> incoming(batch.begin() + skip, batch.end());
+
+    // Evict the oldest values from the ring buffer
+    int evictCount = std::max(0, count + static_cast<int>(incoming.size()) - cap);
+    QVector<int> evicted(evictCount);
+    for (int i = 0; i < evictCount; ++i) {
+        evicted[i] = ring[head];
+        head = (head + 1) % cap;
+    }
+    count -= evictCount;
+
+    for (int value : incoming) {
+        ring[(head + count) % cap] = value;
+        count++;
+    }
+
+    std::sort(incoming.begin(), incoming.end());
+    std::sort(evicted.begin(), evicted.end());
+
+    // Single merge pass: drop evicted values, interleave the sorted batch
+    QVector<int> merged;
+    merged.reserve(count);
+    int i = 0, e = 0, j = 0;
+    while (i < sorted.size()) {
+        if (e < evicted.size() && evicted[e] == sorted[i]) {
+            result.evictedAt.append(i);
+            e++;
+            i++;
+        } else if (j < incoming.size() && incoming[j] < sorted[i]) {
+            result.insertedAt.append(merged.size());
+            merged.append(incoming[j++]);
+        } else {
+            merged.append(sorted[i++]);
+        }
+    }
+    while (j < incoming.size()) {
+        result.insertedAt.append(merged.size());
+        merged.append(incoming[j++]);
+    }
+    sorted.swap(merged);
+
+    result.latencyNs = timer.nsecsElapsed();
+    batches++;
+    totalNs += result.latencyNs;
+    maxNs = std::max(maxNs, result.latencyNs);
+    return result;
+}
@@ -0,0 +1,44 @@
+#ifndef STREAMWINDOW_H
+#define STREAMWINDOW_H
+
+#include <QVector>
+
+// Bounded sliding window over a numeric stream that is kept sorted
+// incrementally. Arrival order lives in a ring buffer so the oldest values can
+// be evicted; every batch is sorted on its own and merged into the sorted
+// window in a single pass that also drops the evicted values.
+class StreamWindow {
+public:
+    struct BatchResult {
+        QVector<int> insertedAt;   // positions of the new values in the sorted window
+        QVector<int> evictedAt;    // positions the evicted values had before the merge
+        qint64 latencyNs = 0;
+    };
+
+    explicit StreamWindow(int capacity = 64);
+
+    BatchResult push(const QVector<int> &batch);
+    void clear();
+
+    const QVector<int> &values() const { return sorted; }
+    int capacity() const { return ring.size(); }
+    int size() const { return sorted.size(); }
+
+    qint64 totalValues() const { return valuesSeen; }
+    qint64 batchCount() const { return batches; }
+    qint64 maxLatencyNs() const { return maxNs; }
+    qint64 averageLatencyNs() const { return batches > 0 ? totalNs / batches : 0; }
+
+private:
+    QVector<int> ring;     // arrival order, head is the oldest value
+    int head = 0;
+    int count = 0;
+    QVector<int> sorted;   // current window in ascending order
+
+    qint64 valuesSeen = 0;
+    qint64 batches = 0;
+    qint64 totalNs = 0;
+    qint64 maxNs = 0;
+};
+
+#endif // STREAMWINDOW_H
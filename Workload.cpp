@@ -0,0 +1,333 @@
+#include "Workload.h"
+#include "ParallelSort.h"
+#include <QFile>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+namespace Workload {
+
+namespace {
+
+const qint64 kChunk = 1 << 16; // elements generated per file write
+const double kPi = 3.14159265358979323846;
+
+// Counter based generator: element i draws from hash(seed, stream, i), so no
+// state is shared between elements or threads
+quint64 splitmix64(quint64 x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+quint64 hash(quint64 seed, quint64 stream, qint64 i) {
+    return splitmix64(splitmix64(seed ^ (stream * 0xd1b54a32d192ed03ULL)) + static_cast<quint64>(i));
+}
+
+// Uniform double in [0, 1)
+double unit(quint64 h) {
+    return (h >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// Per spec constants resolved once before the threads start
+class Generator {
+public:
+    explicit Generator(const Spec &spec) : spec(spec) {
+        width = spec.bits == 64 ? 64 : 32;
+        fullWidth = spec.range == 0 || (width == 32 && spec.range >= (1ULL << 32));
+        maxRank = fullWidth ? (width == 64 ? ~0ULL : 0xffffffffULL) : spec.range - 1;
+        span = static_cast<long double>(maxRank) + 1;
+
+        // Drop just enough low bits for the range to fit an int, 31 bits
+        // when unsigned so the working array stays non-negative
+        int rankBits = 0;
+        while (rankBits < 64 && (maxRank >> rankBits) != 0) {
+            rankBits++;
+        }
+        shift = std::max(0, rankBits - (spec.isSigned ? 32 : 31));
+
+        parameter = spec.parameter;
+        if (parameter <= 0) {
+            switch (spec.distribution) {
+            case Distribution::Zipf: parameter = 1.1; break;
+            case Distribution::Gaussian: parameter = 0.125; break;
+            case Distribution::KSorted: parameter = 16; break;
+            case Distribution::ManyDuplicates: parameter = 16; break;
+            case Distribution::Sawtooth: parameter = 64; break;
+            default: break;
+            }
+        }
+    }
+
+    // Value of element i as raw bits, two's complement when signed
+    quint64 at(qint64 i) const {
+        quint64 r = rank(i);
+        if (spec.isSigned) {
+            r -= static_cast<quint64>(span / 2); // centre on zero, wraps like two's complement
+            if (width == 32) {
+                r = static_cast<quint64>(static_cast<qint64>(static_cast<qint32>(r)));
+            }
+        }
+        return r;
+    }
+
+    // Order preserving reduction to the 32-bit working array
+    int toInt(quint64 value) const {
+        if (spec.isSigned) {
+            return static_cast<int>(static_cast<qint64>(value) >> shift);
+        }
+        return static_cast<int>(value >> shift);
+    }
+
+private:
+    quint64 clampRank(long double x) const {
+        if (!(x > 0)) {
+            return 0;
+        }
+        return x >= static_cast<long double>(maxRank) ? maxRank : static_cast<quint64>(x);
+    }
+
+    // Rank of sorted position j in [0, size)
+    quint64 sortedRank(qint64 j) const {
+        return clampRank(static_cast<long double>(j) * span / std::max<qint64>(1, spec.size));
+    }
+
+    quint64 rank(qint64 i) const {
+        const qint64 n = spec.size;
+        switch (spec.distribution) {
+        case Distribution::Uniform: {
+            quint64 h = hash(spec.seed, 0, i);
+            if (fullWidth) {
+                return h >> (64 - width);
+            }
+            return h % (maxRank + 1);
+        }
+        case Distribution::Zipf: {
+            // Inverse of the continuous Zipf CDF over ranks 1 .. span
+            long double u = unit(hash(spec.seed, 1, i));
+            long double a = 1.0L - parameter;
+            long double x = std::fabs(a) < 1e-9L ? std::pow(span + 1, u)
+                                                  : std::pow(1 + u * (std::pow(span + 1, a) - 1), 1 / a);
+            return clampRank(std::floor(x) - 1);
+        }
+        case Distribution::Gaussian: {
+            // Box-Muller, centred in the range
+            double u1 = 1.0 - unit(hash(spec.seed, 2, i));
+            double u2 = unit(hash(spec.seed, 3, i));
+            double z = std::sqrt(-2.0 * std::log(u1)) * std::cos(2.0 * kPi * u2);
+            return clampRank(span / 2 + z * parameter * span);
+        }
+        case Distribution::Sorted:
+            return sortedRank(i);
+        case Distribution::Reverse:
+            return sortedRank(n - 1 - i);
+        case Distribution::KSorted: {
+            // Aligned blocks of the largest power of two p <= k + 1. Each block
+            // pairs position j with j ^ d for a hashed d and swaps every pair
+            // on a hashed coin, an involution, so the result is a permutation
+            // of the sorted ranks and nothing moves more than p - 1 <= k places
+            qint64 block = 1;
+            while (block * 2 <= static_cast<qint64>(parameter) + 1) {
+                block *= 2;
+            }
+            const qint64 base = i - i % block;
+            const qint64 partner = base + ((i - base) ^ static_cast<qint64>(hash(spec.seed, 4, base) % block));
+            if (partner < n && (hash(spec.seed, 6, std::min(i, partner)) & 1)) {
+                return sortedRank(partner);
+            }
+            return sortedRank(i);
+        }
+        case Distribution::ManyDuplicates: {
+            quint64 distinct = static_cast<quint64>(parameter);
+            return clampRank((hash(spec.seed, 5, i) % distinct) * span / distinct);
+        }
+        case Distribution::Sawtooth: {
+            qint64 period = static_cast<qint64>(parameter);
+            return clampRank((i % period) * span / period);
+        }
+        case Distribution::QuickSortAdversary: {
+            // Musser's median-of-3 killer on the largest prefix with n/2 even,
+            // the remaining tail is left ascending
+            qint64 m = n - n % 4;
+            qint64 k = m / 2;
+            qint64 value;
+            if (i >= m) {
+                value = i + 1;
+            } else if (i < k) {
+                value = i % 2 == 0 ? i + 1 : k + i;
+            } else {
+                value = 2 * (i - k + 1);
+            }
+            return sortedRank(value - 1);
+        }
+        }
+        return 0;
+    }
+
+    Spec spec;
+    int width;
+    bool fullWidth;
+    quint64 maxRank;
+    int shift;
+    long double span;
+    double parameter;
+};
+
+struct DistributionName {
+    Distribution distribution;
+    const char *name;
+};
+
+const DistributionName kDistributionNames[] = {
+    {Distribution::Uniform, "uniform"},
+    {Distribution::Zipf, "zipf"},
+    {Distribution::Gaussian, "gaussian"},
+    {Distribution::Sorted, "sorted"},
+    {Distribution::Reverse, "reverse"},
+    {Distribution::KSorted, "ksorted"},
+    {Distribution::ManyDuplicates, "duplicates"},
+    {Distribution::Sawtooth, "sawtooth"},
+    {Distribution::QuickSortAdversary, "adversary"},
+};
+
+Spec makeSpec(const QString &name, Distribution distribution, qint64 size, int bits, bool isSigned,
+              quint64 range, double parameter = 0) {
+    Spec spec;
+    spec.name = name;
+    spec.distribution = distribution;
+    spec.size = size;
+    spec.seed = 42;
+    spec.bits = bits;
+    spec.isSigned = isSigned;
+    spec.range = range;
+    spec.parameter = parameter;
+    return spec;
+}
+
+} // namespace
+
+QStringList distributionNames() {
+    QStringList names;
+    for (const DistributionName &entry : kDistributionNames) {
+        names.append(entry.name);
+    }
+    return names;
+}
+
+bool distributionFromName(const QString &name, Distribution *distribution) {
+    for (const DistributionName &entry : kDistributionNames) {
+        if (name == entry.name) {
+            *distribution = entry.distribution;
+            return true;
+        }
+    }
+    return false;
+}
+
+const QVector<Spec> &catalog() {
+    static const QVector<Spec> datasets = [] {
+        QVector<Spec> result;
+        for (const DistributionName &entry : kDistributionNames) {
+            // Small enough to watch in the GUI, values 0..99 like numbers.txt
+            double parameter = entry.distribution == Distribution::KSorted ? 4
+                             : entry.distribution == Distribution::ManyDuplicates ? 5
+                             : entry.distribution == Distribution::Sawtooth ? 12 : 0;
+            result.append(makeSpec(QString("%1-60").arg(entry.name), entry.distribution, 60, 32, false, 100, parameter));
+        }
+        for (const DistributionName &entry : kDistributionNames) {
+            // Benchmark size, full 32-bit signed values
+            result.append(makeSpec(QString("%1-4m").arg(entry.name), entry.distribution, 4000000, 32, true, 0));
+        }
+        result.append(makeSpec("uniform-u32-4m", Distribution::Uniform, 4000000, 32, false, 0));
+        result.append(makeSpec("uniform-i64-4m", Distribution::Uniform, 4000000, 64, true, 0));
+        result.append(makeSpec("uniform-u64-4m", Distribution::Uniform, 4000000, 64, false, 0));
+        return result;
+    }();
+    return datasets;
+}
+
+const Spec *find(const QString &name) {
+    for (const Spec &spec : catalog()) {
+        if (spec.name == name) {
+            return &spec;
+        }
+    }
+    return nullptr;
+}
+
+void generate(const Spec &spec, QVector<int> &out, int threads) {
+    const Generator generator(spec);
+    const qint64 n = spec.size;
+    out.resize(static_cast<int>(n));
+    int *data = out.data();
+
+    if (threads <= 0) {
+        threads = ParallelSort::defaultThreadCount();
+    }
+    threads = static_cast<int>(std::max<qint64>(1, std::min<qint64>(threads, n / kChunk + 1)));
+    ParallelSort::runParallel(threads, [&](int t) {
+        qint64 begin = n * t / threads;
+        qint64 end = n * (t + 1) / threads;
+        for (qint64 i = begin; i < end; ++i) {
+            data[i] = generator.toInt(generator.at(i));
+        }
+    });
+}
+
+bool writeBinary(const Spec &spec, const QString &path, int threads, QString *error) {
+    const Generator generator(spec);
+    const qint64 n = spec.size;
+    const int bytes = spec.bits == 64 ? 8 : 4;
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || !file.resize(n * bytes)) {
+        if (error) {
+            *error = file.errorString();
+        }
+        return false;
+    }
+    file.close();
+
+    if (threads <= 0) {
+        threads = ParallelSort::defaultThreadCount();
+    }
+    threads = static_cast<int>(std::max<qint64>(1, std::min<qint64>(threads, n / kChunk + 1)));
+    std::atomic<bool> failed(false);
+    ParallelSort::runParallel(threads, [&](int t) {
+        qint64 begin = n * t / threads;
+        qint64 end = n * (t + 1) / threads;
+        QFile slice(path);
+        if (!slice.open(QIODevice::ReadWrite) || !slice.seek(begin * bytes)) {
+            failed = true;
+            return;
+        }
+
+        QByteArray buffer;
+        for (qint64 chunk = begin; chunk < end && !failed; chunk += kChunk) {
+            qint64 count = std::min(kChunk, end - chunk);
+            buffer.resize(static_cast<int>(count * bytes));
+            if (bytes == 8) {
+                quint64 *values = reinterpret_cast<quint64 *>(buffer.data());
+                for (qint64 i = 0; i < count; ++i) {
+                    values[i] = generator.at(chunk + i);
+                }
+            } else {
+                quint32 *values = reinterpret_cast<quint32 *>(buffer.data());
+                for (qint64 i = 0; i < count; ++i) {
+                    values[i] = static_cast<quint32>(generator.at(chunk + i));
+                }
+            }
+            if (slice.write(buffer) != buffer.size()) {
+                failed = true;
+            }
+        }
+    });
+
+    if (failed && error) {
+        *error = "Failed to write " + path;
+    }
+    return !failed;
+}
+
+} // namespace Workload
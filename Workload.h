@@ -0,0 +1,53 @@
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// Seeded, deterministic input generator and the named dataset catalog shared
+// by the GUI and the headless benchmarks. Element i is a pure function of
+// (seed, i), so the output is identical no matter how many threads fill it.
+namespace Workload {
+
+enum class Distribution {
+    Uniform,
+    Zipf,               // parameter: exponent (default 1.1)
+    Gaussian,           // parameter: standard deviation as a fraction of the range (default 0.125)
+    Sorted,
+    Reverse,
+    KSorted,            // parameter: k, a permutation of the sorted values moving none more than k places (default 16)
+    ManyDuplicates,     // parameter: number of distinct values (default 16)
+    Sawtooth,           // parameter: period (default 64)
+    QuickSortAdversary  // Musser's median-of-3 killer permutation
+};
+
+struct Spec {
+    QString name;
+    Distribution distribution = Distribution::Uniform;
+    qint64 size = 0;
+    quint64 seed = 1;
+    int bits = 32;          // 32 or 64
+    bool isSigned = false;  // signed values are centred on zero
+    quint64 range = 0;      // number of distinct magnitudes, 0 uses the full width
+    double parameter = 0;   // distribution specific, 0 picks the default
+};
+
+// Named datasets, small ones for the GUI and multi-million element ones for
+// the benchmarks.
+const QVector<Spec> &catalog();
+const Spec *find(const QString &name);
+QStringList distributionNames();
+bool distributionFromName(const QString &name, Distribution *distribution);
+
+// Fill the working array in parallel. The array is 32-bit, so ranges wider
+// than an int drop their low bits (order preserving).
+void generate(const Spec &spec, QVector<int> &out, int threads = 0);
+
+// Stream the dataset to a raw binary file of 32- or 64-bit native-endian
+// values, every thread writes its own slice through its own file handle.
+bool writeBinary(const Spec &spec, const QString &path, int threads = 0, QString *error = nullptr);
+
+} // namespace Workload
+
+#endif // WORKLOAD_H
@@ -1,7 +1,30 @@
 #include <QApplication>
+#include <QCoreApplication>
+#include <cstring>
 #include "SortingVisualizer.h"
+#include "Benchmark.h"
 
 int main(int argc, char *argv[]) {
+    // Headless modes do not need a display
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--bench") == 0) {
+            QCoreApplication app(argc, argv);
+            return runBenchmark(app.arguments());
+        } else if (std::strcmp(argv[i], "--generate") == 0) {
+            QCoreApplication app(argc, argv);
+            return runGenerator(app.arguments());
+        } else if (std::strcmp(argv[i], "--list-datasets") == 0) {
+            return listDatasets();
+        } else if (std::strcmp(argv[i], "--export") == 0) {
+            // Rendering needs fonts but no window
+            if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+                qputenv("QT_QPA_PLATFORM", "offscreen");
+            }
+            QApplication app(argc, argv);
+            return runExport(app.arguments());
+        }
+    }
+
     QApplication app(argc, argv);
 
     SortingVisualizer visualizer;